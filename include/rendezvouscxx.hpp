@@ -1,38 +1,39 @@
 #pragma once
 
 #include <rendezvouscxx/i_server.hpp>
+#include <rendezvouscxx/profiler.hpp>
+#include <rendezvouscxx/trace.hpp>
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <type_traits>
 #include <utility>
 
-#ifdef RENDEZVOUSCXX_ENABLE_TRACE
-#include <iostream>
-#include <sstream>
-#include <thread>
-#define RENDEZVOUSCXX_TRACE(message) \
-    do \
-    { \
-        std::ostringstream stream; \
-        stream << "[RendesVousCxx] thread " << std::this_thread::get_id() << " " << message << std::endl; \
-        std::cout << stream.str(); \
-    } while (false)
-#else
-#define RENDEZVOUSCXX_TRACE(message) do {} while (false)
-#endif
+namespace rendezvouscxx
+{
 
-#ifdef RENDEZVOUSCXX_ENABLE_WAIT_COUNTER
-#include <atomic>
-#define RENDEZVOUSCXX_INCREMENT_WAIT_COUNTER (++m_wait_count, (void)0)
-#else
-#define RENDEZVOUSCXX_INCREMENT_WAIT_COUNTER ((void)0)
-#endif
+using lease_duration_t = std::chrono::steady_clock::duration;
 
-namespace rendezvouscxx
+class session_revoked_error : public std::runtime_error
+{
+public:
+    session_revoked_error() :
+        std::runtime_error("The session has been revoked on lease expiry")
+    {}
+};
+
+struct gate_stats_t
 {
+    std::uint64_t session_count;
+    std::uint64_t lease_expiry_count;
+};
 
 template <typename ISrv>
 class gate_t
@@ -43,9 +44,10 @@ public:
     class client_guard_t
     {
     public:
-        client_guard_t(gate_t<ISrv>& gate, std::unique_lock<std::mutex> lock) :
+        client_guard_t(gate_t<ISrv>& gate, ISrv& server, std::uint64_t session) :
             m_gate(gate),
-            m_lock(std::move(lock))
+            m_server(server),
+            m_session(session)
         {
             RENDEZVOUSCXX_TRACE("client_guard_t ctor");
         }
@@ -53,21 +55,34 @@ public:
         ~client_guard_t()
         {
             RENDEZVOUSCXX_TRACE("client_guard_t dtor");
-            m_gate.on_client_disconnecting();
+            m_gate.on_client_disconnecting(m_session);
         }
 
         client_guard_t(client_guard_t const&) = delete;
         client_guard_t& operator=(client_guard_t const&) = delete;
 
+        // Throws session_revoked_error once the gate has revoked the session.
+        // The check races with a revocation happening at the same time.
         ISrv& server()
         {
             RENDEZVOUSCXX_TRACE("client_guard_t::server()");
-            return *m_gate.m_server;
+            if (is_revoked())
+            {
+                throw session_revoked_error();
+            }
+
+            return m_server;
+        }
+
+        bool is_revoked() const
+        {
+            return m_gate.m_live_session.load(std::memory_order_acquire) != m_session;
         }
 
     private:
         gate_t<ISrv>& m_gate;
-        std::unique_lock<std::mutex> m_lock;
+        ISrv& m_server;
+        std::uint64_t const m_session;
     };
 
     class client_t
@@ -82,6 +97,28 @@ public:
             return m_gate.connect_client();
         }
 
+        // The server revokes the session if it lasts longer than the lease.
+        // A client can only shorten the lease set by the server, see
+        // server_t::connect(), not extend it or opt out of it.
+        template <typename Rep, typename Period>
+        std::unique_ptr<client_guard_t> connect(std::chrono::duration<Rep, Period> lease)
+        {
+            return m_gate.connect_client(to_lease_duration(lease));
+        }
+
+        // The call site is attributed the wait and hold times when the gate
+        // is built with RENDEZVOUSCXX_ENABLE_PROFILER and ignored otherwise.
+        std::unique_ptr<client_guard_t> connect(call_site_t const& site)
+        {
+            return m_gate.connect_client(std::nullopt, site);
+        }
+
+        template <typename Rep, typename Period>
+        std::unique_ptr<client_guard_t> connect(std::chrono::duration<Rep, Period> lease, call_site_t const& site)
+        {
+            return m_gate.connect_client(to_lease_duration(lease), site);
+        }
+
     private:
         gate_t<ISrv>& m_gate;
     };
@@ -98,13 +135,30 @@ public:
             return m_gate.connect_server(server);
         }
 
+        // Revokes the session if the client holds the server longer than the
+        // lease, whatever the client has asked for. Revocation does not wait
+        // for the client: a call it has started on the server before may still
+        // be running, and a call may even start after the is_revoked() check
+        // in server() has passed. So with a lease the server is no longer
+        // accessed exclusively by one client.
+        template <typename Rep, typename Period>
+        bool connect(ISrv& server, std::chrono::duration<Rep, Period> lease)
+        {
+            return m_gate.connect_server(server, to_lease_duration(lease));
+        }
+
     private:
         gate_t<ISrv>& m_gate;
     };
 
     gate_t() :
         m_is_client_connected { false },
-        m_server { nullptr }
+        m_server { nullptr },
+        m_is_mutual_connection { false },
+        m_is_closed { false },
+        m_session_count { 0 },
+        m_live_session { 0 },
+        m_lease_expiry_count { 0 }
     {}
 
     client_t client()
@@ -117,16 +171,44 @@ public:
         return server_t(*this);
     }
 
-    std::unique_ptr<client_guard_t> connect_client()
+    std::unique_ptr<client_guard_t> connect_client(
+        std::optional<lease_duration_t> lease = std::nullopt,
+        call_site_t const& site = call_site_t {})
     {
+#ifdef RENDEZVOUSCXX_ENABLE_PROFILER
+        profile_sample_t sample { site, m_profiler.should_sample(), {}, {}, {} };
+        if (sample.is_sampled)
+        {
+            sample.started = contention_profiler_t::clock_t::now();
+        }
+#else
+        (void)site;
+#endif
+
         RENDEZVOUSCXX_TRACE("connect_client() waits for the client mutex");
         std::unique_lock client_lock(m_mx_client);
+        RENDEZVOUSCXX_PREEMPTION_POINT();
 
         RENDEZVOUSCXX_TRACE("connect_client() waits for the common mutex");
         std::unique_lock common_lock(m_mx_common);
 
+        RENDEZVOUSCXX_TRACE("connect_client() waits for the previous session to end");
+        m_cv_disconnected.wait(
+            common_lock,
+            [this]()
+            {
+                RENDEZVOUSCXX_INCREMENT_WAIT_COUNTER;
+                return (!m_is_client_connected && !m_is_mutual_connection) || m_is_closed;
+            });
+
+        if (m_is_closed)
+        {
+            return nullptr;
+        }
+
         RENDEZVOUSCXX_TRACE("connect_client() notifies about getting connected");
         m_is_client_connected = true;
+        m_lease = lease;
         m_cv_client_chaned.notify_all();
 
         RENDEZVOUSCXX_TRACE("connect_client() waits for the server");
@@ -141,16 +223,28 @@ public:
         }
 
         m_is_mutual_connection = true;
+        auto const session = ++m_session_count;
+        m_live_session.store(session, std::memory_order_release);
+        m_cv_client_chaned.notify_all();
+
+#ifdef RENDEZVOUSCXX_ENABLE_PROFILER
+        if (sample.is_sampled)
+        {
+            sample.connected = contention_profiler_t::clock_t::now();
+        }
+        m_profile_sample = sample;
+#endif
 
         RENDEZVOUSCXX_TRACE("connect_client() has established a mutual connection");
         static_cast<i_server*>(m_server)->on_client_connected();
-        return std::make_unique<client_guard_t>(*this, std::move(client_lock));
+        return std::make_unique<client_guard_t>(*this, *m_server, session);
     }
 
-    bool connect_server(ISrv& server)
+    bool connect_server(ISrv& server, std::optional<lease_duration_t> lease = std::nullopt)
     {
         RENDEZVOUSCXX_TRACE("connect_server() waits for the server mutex");
         std::unique_lock lock(m_mx_server);
+        RENDEZVOUSCXX_PREEMPTION_POINT();
 
         RENDEZVOUSCXX_TRACE("connect_server() waits for the common mutex");
         std::unique_lock common_lock(m_mx_common);
@@ -169,13 +263,40 @@ public:
         m_server = &server;
         m_cv_server_chaned.notify_all();
 
-        RENDEZVOUSCXX_TRACE("connect_server() has got a client and waits it to get disconnected");
+        RENDEZVOUSCXX_TRACE("connect_server() has got a client and waits for a mutual connection");
         m_cv_client_chaned.wait(
             common_lock,
-            [this]() { return !m_is_client_connected || m_is_closed; });
+            [this]() { return m_is_mutual_connection || m_is_closed; });
+
+        RENDEZVOUSCXX_TRACE("connect_server() waits the client to get disconnected");
+        auto const is_disconnected = [this]() { return !m_is_client_connected || m_is_closed; };
+        if (m_lease && (!lease || *m_lease < *lease))
+        {
+            lease = m_lease;
+        }
+
+        if (lease && !m_is_closed)
+        {
+            auto const deadline = lease_deadline(*lease);
+            if (!m_cv_client_chaned.wait_until(common_lock, deadline, is_disconnected))
+            {
+                auto const sample = revoke_session(server);
+                common_lock.unlock();
+                record_profile_sample(sample);
+                return true;
+            }
+        }
+        else
+        {
+            m_cv_client_chaned.wait(common_lock, is_disconnected);
+        }
 
         RENDEZVOUSCXX_TRACE("connect_server() breaks the mutual connection");
         m_is_mutual_connection = false;
+        if (!m_is_client_connected)
+        {
+            m_live_session.store(0, std::memory_order_release);
+        }
         m_cv_disconnected.notify_all();
 
         return true;
@@ -183,6 +304,7 @@ public:
 
     void close()
     {
+        RENDEZVOUSCXX_PREEMPTION_POINT();
         {
             std::unique_lock common_lock(m_mx_common);
             m_is_closed = true;
@@ -190,28 +312,136 @@ public:
 
         m_cv_client_chaned.notify_all();
         m_cv_server_chaned.notify_all();
+        m_cv_disconnected.notify_all();
+    }
+
+    gate_stats_t stats()
+    {
+        std::unique_lock common_lock(m_mx_common);
+        return gate_stats_t { m_session_count, m_lease_expiry_count };
     }
 
 #ifdef RENDEZVOUSCXX_ENABLE_WAIT_COUNTER
     std::uint32_t wait_count() const { return m_wait_count; }
 #endif
 
+#ifdef RENDEZVOUSCXX_ENABLE_PROFILER
+    contention_profiler_t& profiler() { return m_profiler; }
+#endif
+
 private:
-    void on_client_disconnecting()
+    // Leases such as std::chrono::hours::max() do not fit into lease_duration_t
+    // and saturate to its maximum instead of overflowing.
+    template <typename Rep, typename Period>
+    static lease_duration_t to_lease_duration(std::chrono::duration<Rep, Period> lease)
+    {
+        using seconds_t = std::chrono::duration<double>;
+        if (seconds_t(lease) >= seconds_t(lease_duration_t::max()))
+        {
+            return lease_duration_t::max();
+        }
+
+        return std::chrono::duration_cast<lease_duration_t>(lease);
+    }
+
+    // Saturates rather than overflows for leases as long as lease_duration_t::max().
+    static std::chrono::steady_clock::time_point lease_deadline(lease_duration_t lease)
+    {
+        using time_point_t = std::chrono::steady_clock::time_point;
+        auto const now = std::chrono::steady_clock::now();
+        if (lease > time_point_t::max() - now)
+        {
+            return time_point_t::max();
+        }
+
+        return now + lease;
+    }
+
+    // The timing of one connection, copied out of the gate under the common
+    // mutex and passed to the profiler only after the mutex is released.
+    struct profile_sample_t
     {
+        call_site_t site;
+        bool is_sampled;
+        contention_profiler_t::clock_t::time_point started;
+        contention_profiler_t::clock_t::time_point connected;
+        contention_profiler_t::clock_t::time_point disconnected;
+    };
+
+    profile_sample_t revoke_session(ISrv& server)
+    {
+        RENDEZVOUSCXX_TRACE("revoke_session() revokes the session on lease expiry");
+        ++m_lease_expiry_count;
+        static_cast<i_server*>(&server)->on_lease_expired();
+
+        m_is_client_connected = false;
+        m_server = nullptr;
+        m_is_mutual_connection = false;
+        m_live_session.store(0, std::memory_order_release);
+        m_cv_disconnected.notify_all();
+
+        return take_profile_sample();
+    }
+
+    void on_client_disconnecting(std::uint64_t session)
+    {
+        RENDEZVOUSCXX_PREEMPTION_POINT();
         RENDEZVOUSCXX_TRACE("on_client_disconnecting() waits for the common mutex");
         std::unique_lock lock(m_mx_common);
 
+        if (m_live_session.load(std::memory_order_relaxed) != session)
+        {
+            RENDEZVOUSCXX_TRACE("on_client_disconnecting() finds the session revoked");
+            return;
+        }
+
         RENDEZVOUSCXX_TRACE("on_client_disconnecting() notifies about getting disconnected");
         static_cast<i_server*>(m_server)->on_client_disconnecting();
         m_is_client_connected = false;
         m_server = nullptr;
         m_cv_client_chaned.notify_all();
+        auto const sample = take_profile_sample();
 
         RENDEZVOUSCXX_TRACE("on_client_disconnecting() waits for disconnection to be confirmed");
         m_cv_disconnected.wait(
             lock,
-            [this]() { return !m_is_mutual_connection; });
+            [this, session]()
+            {
+                return m_live_session.load(std::memory_order_relaxed) != session || !m_is_mutual_connection;
+            });
+
+        lock.unlock();
+        record_profile_sample(sample);
+    }
+
+    // Must be called under the common mutex.
+    profile_sample_t take_profile_sample()
+    {
+        profile_sample_t sample {};
+#ifdef RENDEZVOUSCXX_ENABLE_PROFILER
+        if (m_profile_sample.is_sampled)
+        {
+            sample = m_profile_sample;
+            sample.disconnected = contention_profiler_t::clock_t::now();
+            m_profile_sample.is_sampled = false;
+        }
+#endif
+        return sample;
+    }
+
+    void record_profile_sample(profile_sample_t const& sample)
+    {
+#ifdef RENDEZVOUSCXX_ENABLE_PROFILER
+        if (sample.is_sampled)
+        {
+            m_profiler.record(
+                sample.site,
+                sample.connected - sample.started,
+                sample.disconnected - sample.connected);
+        }
+#else
+        (void)sample;
+#endif
     }
 
     std::mutex m_mx_client;
@@ -226,10 +456,19 @@ private:
     ISrv* m_server;
     bool m_is_mutual_connection;
     bool m_is_closed;
+    std::optional<lease_duration_t> m_lease;
+    std::uint64_t m_session_count;
+    std::atomic<std::uint64_t> m_live_session;
+    std::uint64_t m_lease_expiry_count;
 
 #ifdef RENDEZVOUSCXX_ENABLE_WAIT_COUNTER
     std::atomic_uint32_t m_wait_count;
 #endif
+
+#ifdef RENDEZVOUSCXX_ENABLE_PROFILER
+    contention_profiler_t m_profiler;
+    profile_sample_t m_profile_sample {};
+#endif
 };
 
 template <typename ISrv>
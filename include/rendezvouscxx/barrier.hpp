@@ -0,0 +1,260 @@
+#pragma once
+
+#include <rendezvouscxx/parking_lot.hpp>
+#include <rendezvouscxx/trace.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace rendezvouscxx
+{
+
+// A meeting point of a fixed group of participants: each phase completes when
+// all of them have arrived, and the last one to arrive runs the completion
+// before anybody is released. Arrivals are combined in a tree of counters with
+// a small fan-in, so a phase costs O(log N) transfers of contended cache lines
+// and each participant only ever waits on the node where it has lost.
+class barrier_t
+{
+public:
+    class participant_t
+    {
+    public:
+        participant_t(barrier_t& barrier, std::size_t index) :
+            m_barrier(barrier),
+            m_index(index)
+        {}
+
+        bool arrive_and_wait()
+        {
+            return m_barrier.arrive_and_wait(m_index);
+        }
+
+    private:
+        barrier_t& m_barrier;
+        std::size_t m_index;
+    };
+
+    explicit barrier_t(std::size_t participant_count, std::function<void()> completion = {}) :
+        m_participant_count { participant_count },
+        m_nodes(node_count(participant_count)),
+        m_completion(std::move(completion)),
+        m_is_closed { false },
+        m_wait_count { 0 }
+    {
+        std::size_t level_begin = 0;
+        std::size_t child_count = participant_count;
+        for (;;)
+        {
+            auto const level_width = (child_count + fan_in - 1) / fan_in;
+            for (std::size_t i = 0; i < level_width; ++i)
+            {
+                auto& node = m_nodes[level_begin + i];
+                node.expected = static_cast<std::uint32_t>(std::min(fan_in, child_count - i * fan_in));
+                node.parent = level_width == 1 ? no_parent : level_begin + level_width + i / fan_in;
+            }
+
+            if (level_width <= 1)
+            {
+                break;
+            }
+
+            level_begin += level_width;
+            child_count = level_width;
+        }
+    }
+
+    barrier_t(barrier_t const&) = delete;
+    barrier_t& operator=(barrier_t const&) = delete;
+
+    // Each participant of the group must use its own index in [0, participant_count).
+    // Throws std::out_of_range for an index outside of that range.
+    participant_t participant(std::size_t index)
+    {
+        check_index(index);
+        return participant_t(*this, index);
+    }
+
+    // Returns false if the barrier gets closed before the phase completes.
+    // If the completion throws, the barrier gets closed, so that the rest of
+    // the group returns false, and the exception propagates to the caller.
+    bool arrive_and_wait(std::size_t participant)
+    {
+        check_index(participant);
+
+        if (m_is_closed.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        std::array<std::size_t, std::numeric_limits<std::size_t>::digits> won_nodes;
+        std::size_t won_count = 0;
+
+        for (auto index = participant / fan_in; ; )
+        {
+            auto& node = m_nodes[index];
+            auto const phase = node.phase.load(std::memory_order_acquire);
+
+            if (node.count.fetch_add(1, std::memory_order_acq_rel) + 1 < node.expected)
+            {
+                RENDEZVOUSCXX_TRACE("barrier_t::arrive_and_wait() waits for the rest of the node");
+                RENDEZVOUSCXX_INCREMENT_WAIT_COUNTER;
+                if (!wait(node, phase))
+                {
+                    return false;
+                }
+                break;
+            }
+
+            node.count.store(0, std::memory_order_relaxed);
+            won_nodes[won_count++] = index;
+
+            if (node.parent == no_parent)
+            {
+                RENDEZVOUSCXX_TRACE("barrier_t::arrive_and_wait() runs the completion");
+                if (m_completion)
+                {
+                    try
+                    {
+                        m_completion();
+                    }
+                    catch (...)
+                    {
+                        close();
+                        throw;
+                    }
+                }
+                break;
+            }
+
+            index = node.parent;
+        }
+
+        while (won_count > 0)
+        {
+            release(m_nodes[won_nodes[--won_count]]);
+        }
+
+        return true;
+    }
+
+    void close()
+    {
+        m_is_closed.store(true, std::memory_order_seq_cst);
+
+        auto& lot = detail::parking_lot_t::instance();
+        for (auto& node : m_nodes)
+        {
+            if (node.parked.load(std::memory_order_seq_cst) != 0)
+            {
+                auto lock = lot.lock(&node.phase);
+                lot.unpark_all(lock, &node.phase, 0);
+            }
+        }
+    }
+
+    // Counts participants that have started waiting. Stays zero unless
+    // RENDEZVOUSCXX_ENABLE_WAIT_COUNTER is defined, but is always there, so
+    // that the class has the same layout in all translation units.
+    std::uint32_t wait_count() const { return m_wait_count; }
+
+private:
+    static constexpr std::size_t fan_in = 4;
+    static constexpr std::size_t no_parent = std::numeric_limits<std::size_t>::max();
+    static constexpr int spin_count = 128;
+
+    struct alignas(64) node_t
+    {
+        std::atomic<std::uint32_t> count { 0 };
+        std::atomic<std::uint32_t> phase { 0 };
+        std::atomic<std::uint32_t> parked { 0 };
+        std::uint32_t expected = 0;
+        std::size_t parent = no_parent;
+    };
+
+    static std::size_t node_count(std::size_t participant_count)
+    {
+        std::size_t count = 0;
+        for (auto width = participant_count; ; )
+        {
+            width = (width + fan_in - 1) / fan_in;
+            count += width;
+            if (width <= 1)
+            {
+                return count;
+            }
+        }
+    }
+
+    void check_index(std::size_t index) const
+    {
+        if (index >= m_participant_count)
+        {
+            throw std::out_of_range("The participant index is out of the group");
+        }
+    }
+
+    bool wait(node_t& node, std::uint32_t phase)
+    {
+        for (int i = 0; i < spin_count; ++i)
+        {
+            if (node.phase.load(std::memory_order_acquire) != phase)
+            {
+                return true;
+            }
+        }
+
+        auto& lot = detail::parking_lot_t::instance();
+
+        node.parked.fetch_add(1, std::memory_order_seq_cst);
+        auto lock = lot.lock(&node.phase);
+
+        bool is_released = false;
+        for (;;)
+        {
+            if (node.phase.load(std::memory_order_seq_cst) != phase)
+            {
+                is_released = true;
+                break;
+            }
+
+            if (m_is_closed.load(std::memory_order_seq_cst))
+            {
+                break;
+            }
+
+            lot.park(lock, &node.phase, 0);
+        }
+
+        node.parked.fetch_sub(1, std::memory_order_relaxed);
+        return is_released;
+    }
+
+    static void release(node_t& node)
+    {
+        node.phase.fetch_add(1, std::memory_order_seq_cst);
+
+        if (node.parked.load(std::memory_order_seq_cst) != 0)
+        {
+            auto& lot = detail::parking_lot_t::instance();
+            auto lock = lot.lock(&node.phase);
+            lot.unpark_all(lock, &node.phase, 0);
+        }
+    }
+
+    std::size_t const m_participant_count;
+    std::vector<node_t> m_nodes;
+    std::function<void()> m_completion;
+    std::atomic_bool m_is_closed;
+    std::atomic_uint32_t m_wait_count;
+};
+
+} // namespace rendezvouscxx
@@ -0,0 +1,285 @@
+#pragma once
+
+#include <rendezvouscxx/i_server.hpp>
+#include <rendezvouscxx/parking_lot.hpp>
+#include <rendezvouscxx/trace.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace rendezvouscxx
+{
+
+// The same rendezvous as gate_t, but the state of a gate is a single word.
+// Waiting clients and servers are parked in the global parking lot keyed by
+// the gate address, so a program can afford a gate per object. Unlike gate_t,
+// closing the gate does not interrupt a session in progress: the server
+// returns from connect() when its client disconnects.
+template <typename ISrv>
+class compact_gate_t
+{
+    static_assert(std::is_base_of_v<i_server, ISrv>, "Must implement the rendezvouscxx::i_server interface");
+
+public:
+    class client_guard_t
+    {
+    public:
+        client_guard_t(compact_gate_t<ISrv>& gate, ISrv& server) :
+            m_gate(gate),
+            m_server(server)
+        {
+            RENDEZVOUSCXX_TRACE("compact_gate_t::client_guard_t ctor");
+        }
+
+        ~client_guard_t()
+        {
+            RENDEZVOUSCXX_TRACE("compact_gate_t::client_guard_t dtor");
+            m_gate.on_client_disconnecting(m_server);
+        }
+
+        client_guard_t(client_guard_t const&) = delete;
+        client_guard_t& operator=(client_guard_t const&) = delete;
+
+        ISrv& server()
+        {
+            return m_server;
+        }
+
+    private:
+        compact_gate_t<ISrv>& m_gate;
+        ISrv& m_server;
+    };
+
+    class client_t
+    {
+    public:
+        explicit client_t(compact_gate_t<ISrv>& gate) :
+            m_gate(gate)
+        {}
+
+        std::unique_ptr<client_guard_t> connect()
+        {
+            return m_gate.connect_client();
+        }
+
+    private:
+        compact_gate_t<ISrv>& m_gate;
+    };
+
+    class server_t
+    {
+    public:
+        explicit server_t(compact_gate_t<ISrv>& gate) :
+            m_gate(gate)
+        {}
+
+        bool connect(ISrv& server)
+        {
+            return m_gate.connect_server(server);
+        }
+
+    private:
+        compact_gate_t<ISrv>& m_gate;
+    };
+
+    compact_gate_t() :
+        m_state { 0 }
+    {}
+
+    compact_gate_t(compact_gate_t const&) = delete;
+    compact_gate_t& operator=(compact_gate_t const&) = delete;
+
+    client_t client()
+    {
+        return client_t(*this);
+    }
+
+    server_t server()
+    {
+        return server_t(*this);
+    }
+
+    std::unique_ptr<client_guard_t> connect_client()
+    {
+        if (is_closed())
+        {
+            return nullptr;
+        }
+
+        auto& lot = detail::parking_lot_t::instance();
+        RENDEZVOUSCXX_PREEMPTION_POINT();
+
+        RENDEZVOUSCXX_TRACE("compact_gate_t::connect_client() waits for the parking lot");
+        auto lock = lot.lock(&m_state);
+
+        ISrv* server = take_parked_server(lock);
+        if (server == nullptr)
+        {
+            if (m_state.fetch_or(parked_bit) & closed_bit)
+            {
+                update_parked_bit(lock);
+                return nullptr;
+            }
+
+            RENDEZVOUSCXX_TRACE("compact_gate_t::connect_client() parks until a server comes");
+            server = reinterpret_cast<ISrv*>(lot.park(lock, clients_address(), closed_token));
+            if (server == nullptr)
+            {
+                return nullptr;
+            }
+        }
+
+        lock.unlock();
+        RENDEZVOUSCXX_PREEMPTION_POINT();
+
+        RENDEZVOUSCXX_TRACE("compact_gate_t::connect_client() has established a mutual connection");
+        static_cast<i_server*>(server)->on_client_connected();
+        return std::make_unique<client_guard_t>(*this, *server);
+    }
+
+    bool connect_server(ISrv& server)
+    {
+        if (is_closed())
+        {
+            return false;
+        }
+
+        auto& lot = detail::parking_lot_t::instance();
+        RENDEZVOUSCXX_PREEMPTION_POINT();
+
+        RENDEZVOUSCXX_TRACE("compact_gate_t::connect_server() waits for the parking lot");
+        auto lock = lot.lock(&m_state);
+
+        if (m_state.fetch_or(parked_bit) & closed_bit)
+        {
+            update_parked_bit(lock);
+            return false;
+        }
+
+        if (!(m_state.load(std::memory_order_relaxed) & busy_bit))
+        {
+            if (auto* const client = lot.dequeue(lock, clients_address()))
+            {
+                RENDEZVOUSCXX_TRACE("compact_gate_t::connect_server() hands itself to a parked client");
+                m_state.fetch_or(busy_bit);
+                lot.unpark(lock, *client, reinterpret_cast<std::uintptr_t>(&server));
+                lot.park(lock, session_address(), closed_token);
+                return true;
+            }
+        }
+
+        RENDEZVOUSCXX_TRACE("compact_gate_t::connect_server() parks until a client comes");
+        return lot.park(lock, servers_address(), reinterpret_cast<std::uintptr_t>(&server)) == session_ended_token;
+    }
+
+    void close()
+    {
+        auto const state = m_state.fetch_or(closed_bit);
+        if ((state & closed_bit) || !(state & parked_bit))
+        {
+            return;
+        }
+
+        RENDEZVOUSCXX_PREEMPTION_POINT();
+        auto& lot = detail::parking_lot_t::instance();
+        auto lock = lot.lock(&m_state);
+        lot.unpark_all(lock, clients_address(), closed_token);
+        lot.unpark_all(lock, servers_address(), closed_token);
+        update_parked_bit(lock);
+    }
+
+    // There is no room for a counter in the gate itself,
+    // so these are the waits in the whole parking lot.
+    std::uint32_t wait_count() const { return detail::parking_lot_t::instance().wait_count(); }
+
+private:
+    static constexpr std::uintptr_t closed_bit = 1;
+    static constexpr std::uintptr_t busy_bit = 2;
+    static constexpr std::uintptr_t parked_bit = 4;
+
+    static constexpr std::uintptr_t closed_token = 0;
+    static constexpr std::uintptr_t session_ended_token = 1;
+
+    bool is_closed() const
+    {
+        return m_state.load(std::memory_order_acquire) & closed_bit;
+    }
+
+    // The three queues of a gate: clients and servers waiting for each other
+    // and the server whose client is in a session.
+    void const* clients_address() const { return &m_state; }
+    void const* servers_address() const { return reinterpret_cast<char const*>(&m_state) + 1; }
+    void const* session_address() const { return reinterpret_cast<char const*>(&m_state) + 2; }
+
+    // Moves a parked server, if any, to the session queue and returns it.
+    ISrv* take_parked_server(detail::parking_lot_t::lock_t& lock)
+    {
+        auto const state = m_state.load(std::memory_order_relaxed);
+        if (state & (closed_bit | busy_bit))
+        {
+            return nullptr;
+        }
+
+        auto& lot = detail::parking_lot_t::instance();
+        auto* const server = lot.dequeue(lock, servers_address());
+        if (server == nullptr)
+        {
+            return nullptr;
+        }
+
+        RENDEZVOUSCXX_TRACE("compact_gate_t takes a parked server");
+        m_state.fetch_or(busy_bit);
+        lot.enqueue(lock, *server, session_address());
+        return reinterpret_cast<ISrv*>(server->token);
+    }
+
+    void on_client_disconnecting(ISrv& server)
+    {
+        RENDEZVOUSCXX_TRACE("compact_gate_t::on_client_disconnecting() notifies about getting disconnected");
+        static_cast<i_server*>(&server)->on_client_disconnecting();
+        RENDEZVOUSCXX_PREEMPTION_POINT();
+
+        auto& lot = detail::parking_lot_t::instance();
+        auto lock = lot.lock(&m_state);
+
+        if (auto* const session_server = lot.dequeue(lock, session_address()))
+        {
+            lot.unpark(lock, *session_server, session_ended_token);
+        }
+        m_state.fetch_and(~busy_bit);
+
+        if (lot.find(lock, clients_address()) != nullptr)
+        {
+            if (auto* const next_server = take_parked_server(lock))
+            {
+                RENDEZVOUSCXX_TRACE("compact_gate_t::on_client_disconnecting() hands a server to the next client");
+                lot.unpark(lock, *lot.dequeue(lock, clients_address()), reinterpret_cast<std::uintptr_t>(next_server));
+            }
+        }
+
+        update_parked_bit(lock);
+    }
+
+    void update_parked_bit(detail::parking_lot_t::lock_t& lock)
+    {
+        auto& lot = detail::parking_lot_t::instance();
+        if (lot.find(lock, clients_address()) == nullptr
+            && lot.find(lock, servers_address()) == nullptr
+            && lot.find(lock, session_address()) == nullptr)
+        {
+            m_state.fetch_and(~parked_bit);
+        }
+    }
+
+    std::atomic<std::uintptr_t> m_state;
+};
+
+template <typename ISrv>
+using compact_client_gate_t = typename compact_gate_t<ISrv>::client_t;
+
+template <typename ISrv>
+using compact_server_gate_t = typename compact_gate_t<ISrv>::server_t;
+
+} // namespace rendezvouscxx
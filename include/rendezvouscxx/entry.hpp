@@ -0,0 +1,290 @@
+#pragma once
+
+#include <rendezvouscxx/trace.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace rendezvouscxx
+{
+
+namespace detail
+{
+
+// The waiting point of a server blocked in select() on several entries at once.
+struct selector_t
+{
+    void signal()
+    {
+        std::unique_lock lock(m_mx);
+        m_is_signalled = true;
+        m_cv.notify_one();
+    }
+
+    std::mutex m_mx;
+    std::condition_variable m_cv;
+    bool m_is_signalled = false;
+};
+
+enum class select_status_t
+{
+    accepted,
+    registered,
+    closed
+};
+
+} // namespace detail
+
+template <typename Guard, typename In, typename Out, typename Body>
+class alternative_t;
+
+// A typed entry in the sense of Ada: the client calls the entry passing its own
+// input and output buffers and gets blocked until some server accepts the call.
+// The accept body runs in the server thread directly on the client's buffers,
+// so the parameters are neither copied nor queued anywhere.
+template <typename In, typename Out>
+class entry_t
+{
+public:
+    class client_t
+    {
+    public:
+        explicit client_t(entry_t<In, Out>& entry) :
+            m_entry(entry)
+        {}
+
+        bool call(In const& in, Out& out)
+        {
+            return m_entry.call(in, out);
+        }
+
+    private:
+        entry_t<In, Out>& m_entry;
+    };
+
+    class server_t
+    {
+    public:
+        explicit server_t(entry_t<In, Out>& entry) :
+            m_entry(entry)
+        {}
+
+        template <typename Body>
+        bool accept(Body&& body)
+        {
+            return m_entry.accept(std::forward<Body>(body));
+        }
+
+    private:
+        entry_t<In, Out>& m_entry;
+    };
+
+    entry_t() :
+        m_is_closed { false },
+        m_wait_count { 0 }
+    {}
+
+    entry_t(entry_t const&) = delete;
+    entry_t& operator=(entry_t const&) = delete;
+
+    client_t client()
+    {
+        return client_t(*this);
+    }
+
+    server_t server()
+    {
+        return server_t(*this);
+    }
+
+    // Blocks until a server has run its accept body on the given buffers.
+    // Returns false if the entry gets closed before the call is accepted.
+    // An exception thrown by the accept body is propagated to the caller.
+    bool call(In const& in, Out& out)
+    {
+        call_t call { &in, &out, false, false, nullptr };
+
+        RENDEZVOUSCXX_TRACE("entry_t::call() waits for the mutex");
+        std::unique_lock lock(m_mx);
+
+        if (m_is_closed)
+        {
+            return false;
+        }
+
+        RENDEZVOUSCXX_TRACE("entry_t::call() queues the call");
+        m_calls.push_back(&call);
+        m_cv_call_queued.notify_one();
+        signal_selectors();
+
+        RENDEZVOUSCXX_TRACE("entry_t::call() waits for the call to be accepted");
+        m_cv_call_done.wait(
+            lock,
+            [this, &call]() { RENDEZVOUSCXX_INCREMENT_WAIT_COUNTER; return call.m_is_done || (m_is_closed && !call.m_is_accepted); });
+
+        if (!call.m_is_done)
+        {
+            m_calls.erase(std::find(m_calls.begin(), m_calls.end(), &call));
+            return false;
+        }
+
+        if (call.m_exception)
+        {
+            std::rethrow_exception(call.m_exception);
+        }
+
+        return true;
+    }
+
+    // Blocks until a client calls the entry, then runs body(in, out) on the
+    // client's buffers. Returns false if the entry gets closed while waiting.
+    // An exception thrown by the body is propagated to both parties.
+    template <typename Body>
+    bool accept(Body&& body)
+    {
+        RENDEZVOUSCXX_TRACE("entry_t::accept() waits for the mutex");
+        std::unique_lock lock(m_mx);
+
+        RENDEZVOUSCXX_TRACE("entry_t::accept() waits for a call");
+        m_cv_call_queued.wait(
+            lock,
+            [this]() { RENDEZVOUSCXX_INCREMENT_WAIT_COUNTER; return !m_calls.empty() || m_is_closed; });
+
+        if (m_is_closed)
+        {
+            return false;
+        }
+
+        run(lock, std::forward<Body>(body));
+        return true;
+    }
+
+    void close()
+    {
+        {
+            std::unique_lock lock(m_mx);
+            m_is_closed = true;
+            signal_selectors();
+        }
+
+        m_cv_call_queued.notify_all();
+        m_cv_call_done.notify_all();
+    }
+
+    // Counts blocked calls, accepts and selects. Stays zero unless
+    // RENDEZVOUSCXX_ENABLE_WAIT_COUNTER is defined, but is always there, so
+    // that an instantiation has the same layout in all translation units.
+    std::uint32_t wait_count() const { return m_wait_count; }
+
+private:
+    template <typename Guard, typename I, typename O, typename Body>
+    friend class alternative_t;
+
+    struct call_t
+    {
+        In const* m_in;
+        Out* m_out;
+        bool m_is_accepted;
+        bool m_is_done;
+        std::exception_ptr m_exception;
+    };
+
+    template <typename Body>
+    void run(std::unique_lock<std::mutex>& lock, Body&& body)
+    {
+        call_t& call = *m_calls.front();
+        m_calls.pop_front();
+        call.m_is_accepted = true;
+
+        RENDEZVOUSCXX_TRACE("entry_t::run() runs the accept body");
+        lock.unlock();
+        try
+        {
+            std::forward<Body>(body)(*call.m_in, *call.m_out);
+        }
+        catch (...)
+        {
+            call.m_exception = std::current_exception();
+        }
+        lock.lock();
+
+        RENDEZVOUSCXX_TRACE("entry_t::run() notifies the caller");
+        auto const exception = call.m_exception;
+        call.m_is_done = true;
+        m_cv_call_done.notify_all();
+
+        if (exception)
+        {
+            lock.unlock();
+            std::rethrow_exception(exception);
+        }
+    }
+
+    // Runs the body if a call is already pending, otherwise registers
+    // the selector to get signalled about the next call or closing.
+    template <typename Body>
+    detail::select_status_t try_accept(detail::selector_t& selector, Body&& body)
+    {
+        RENDEZVOUSCXX_TRACE("entry_t::try_accept() waits for the mutex");
+        std::unique_lock lock(m_mx);
+
+        if (m_is_closed)
+        {
+            return detail::select_status_t::closed;
+        }
+
+        if (m_calls.empty())
+        {
+            RENDEZVOUSCXX_TRACE("entry_t::try_accept() registers a selector");
+            RENDEZVOUSCXX_INCREMENT_WAIT_COUNTER;
+            m_selectors.push_back(&selector);
+            return detail::select_status_t::registered;
+        }
+
+        run(lock, std::forward<Body>(body));
+        return detail::select_status_t::accepted;
+    }
+
+    void unregister_selector(detail::selector_t& selector)
+    {
+        std::unique_lock lock(m_mx);
+        m_selectors.erase(std::find(m_selectors.begin(), m_selectors.end(), &selector));
+    }
+
+    void signal_selectors()
+    {
+        for (auto* const selector : m_selectors)
+        {
+            selector->signal();
+        }
+    }
+
+    std::mutex m_mx;
+    std::condition_variable m_cv_call_queued;
+    std::condition_variable m_cv_call_done;
+    std::deque<call_t*> m_calls;
+    std::vector<detail::selector_t*> m_selectors;
+    bool m_is_closed;
+    std::atomic_uint32_t m_wait_count;
+};
+
+template <typename In, typename Out, typename Body>
+bool accept(entry_t<In, Out>& entry, Body&& body)
+{
+    return entry.accept(std::forward<Body>(body));
+}
+
+template <typename In, typename Out>
+using client_entry_t = typename entry_t<In, Out>::client_t;
+
+template <typename In, typename Out>
+using server_entry_t = typename entry_t<In, Out>::server_t;
+
+} // namespace rendezvouscxx
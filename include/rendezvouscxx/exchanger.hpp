@@ -0,0 +1,175 @@
+#pragma once
+
+#include <rendezvouscxx/parking_lot.hpp>
+#include <rendezvouscxx/trace.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace rendezvouscxx
+{
+
+// A symmetric rendezvous of two parties swapping their values: the first one
+// to arrive publishes a pointer to its value and waits, the second one moves
+// the values across and releases the first. Meeting and swapping take a single
+// compare-and-swap; only a party that has to wait goes to the parking lot.
+template <typename T>
+class exchanger_t
+{
+    // The swap runs after the waiting offer has left the slot, so nothing could
+    // release the waiting party if it threw.
+    static_assert(
+        std::is_nothrow_move_constructible_v<T> && std::is_nothrow_move_assignable_v<T> && std::is_nothrow_swappable_v<T>,
+        "Must be movable and swappable without throwing");
+
+public:
+    class party_t
+    {
+    public:
+        explicit party_t(exchanger_t<T>& exchanger) :
+            m_exchanger(exchanger)
+        {}
+
+        bool exchange(T& value)
+        {
+            return m_exchanger.exchange(value);
+        }
+
+    private:
+        exchanger_t<T>& m_exchanger;
+    };
+
+    exchanger_t() :
+        m_slot { nullptr },
+        m_wait_count { 0 }
+    {}
+
+    exchanger_t(exchanger_t const&) = delete;
+    exchanger_t& operator=(exchanger_t const&) = delete;
+
+    party_t party()
+    {
+        return party_t(*this);
+    }
+
+    // Blocks until another party arrives, then replaces the value with the one
+    // of the other party. Returns false, leaving the value intact, if the
+    // exchanger gets closed before the other party arrives.
+    bool exchange(T& value)
+    {
+        auto* offer = m_slot.load(std::memory_order_acquire);
+        for (;;)
+        {
+            if (offer == closed_offer())
+            {
+                return false;
+            }
+
+            if (offer == nullptr)
+            {
+                offer_t own_offer { &value, { waiting } };
+                if (m_slot.compare_exchange_weak(offer, &own_offer, std::memory_order_acq_rel, std::memory_order_acquire))
+                {
+                    RENDEZVOUSCXX_TRACE("exchanger_t::exchange() waits for the other party");
+                    RENDEZVOUSCXX_INCREMENT_WAIT_COUNTER;
+                    return wait(own_offer) == exchanged;
+                }
+
+                continue;
+            }
+
+            if (m_slot.compare_exchange_weak(offer, nullptr, std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                RENDEZVOUSCXX_TRACE("exchanger_t::exchange() swaps with the waiting party");
+                using std::swap;
+                swap(*offer->value, value);
+                complete(*offer, exchanged);
+                return true;
+            }
+        }
+    }
+
+    void close()
+    {
+        auto* const offer = m_slot.exchange(closed_offer(), std::memory_order_acq_rel);
+        if (offer != nullptr && offer != closed_offer())
+        {
+            RENDEZVOUSCXX_TRACE("exchanger_t::close() releases the waiting party");
+            complete(*offer, closed);
+        }
+    }
+
+    // Counts parties that have started waiting. Stays zero unless
+    // RENDEZVOUSCXX_ENABLE_WAIT_COUNTER is defined, but is always there, so
+    // that an instantiation has the same layout in all translation units.
+    std::uint32_t wait_count() const { return m_wait_count; }
+
+private:
+    enum state_t : int
+    {
+        waiting,
+        exchanged,
+        closed
+    };
+
+    struct offer_t
+    {
+        T* value;
+        std::atomic<int> state;
+    };
+
+    static constexpr int spin_count = 128;
+
+    static offer_t* closed_offer()
+    {
+        static offer_t offer { nullptr, { closed } };
+        return &offer;
+    }
+
+    static int wait(offer_t& offer)
+    {
+        for (int i = 0; i < spin_count; ++i)
+        {
+            auto const state = offer.state.load(std::memory_order_acquire);
+            if (state != waiting)
+            {
+                return state;
+            }
+        }
+
+        auto& lot = detail::parking_lot_t::instance();
+        auto lock = lot.lock(&offer);
+        for (;;)
+        {
+            auto const state = offer.state.load(std::memory_order_acquire);
+            if (state != waiting)
+            {
+                return state;
+            }
+
+            lot.park(lock, &offer, 0);
+        }
+    }
+
+    // The offer may be gone as soon as its state is stored, so it is only
+    // used as a parking lot address after that.
+    static void complete(offer_t& offer, int state)
+    {
+        void const* const address = &offer;
+        offer.state.store(state, std::memory_order_release);
+
+        auto& lot = detail::parking_lot_t::instance();
+        auto lock = lot.lock(address);
+        if (auto* const thread = lot.dequeue(lock, address))
+        {
+            lot.unpark(lock, *thread, 0);
+        }
+    }
+
+    std::atomic<offer_t*> m_slot;
+    std::atomic_uint32_t m_wait_count;
+};
+
+} // namespace rendezvouscxx
@@ -9,6 +9,13 @@ public:
     virtual ~i_server() = default;
     virtual void on_client_connected() = 0;
     virtual void on_client_disconnecting() = 0;
+
+    // Called instead of on_client_disconnecting() when the gate revokes
+    // a session that has outlived its lease. The revoked client may still be
+    // inside a call on the server, and the next client may get connected
+    // before that call returns, so a server used with leases must tolerate
+    // concurrent calls from both.
+    virtual void on_lease_expired() {}
 };
 
 } // namespace rendezvouscxx
@@ -0,0 +1,172 @@
+#pragma once
+
+#include <rendezvouscxx/trace.hpp>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace rendezvouscxx
+{
+
+namespace detail
+{
+
+// A thread waiting in the parking lot. Lives on the waiting thread's stack,
+// so the memory used for waiting scales with the number of waiting threads
+// rather than with the number of synchronisation objects.
+struct parked_thread_t
+{
+    void const* address;
+    std::uintptr_t token;
+    parked_thread_t* next;
+    bool is_unparked;
+    std::condition_variable cv;
+};
+
+// A global hash table mapping addresses to queues of parked threads, so that
+// a synchronisation primitive only needs a single word of its own state.
+// All the addresses within one machine word hash into the same bucket, which
+// lets a primitive keep several queues (at address, address + 1, ...) that
+// are all guarded by the same bucket lock.
+class parking_lot_t
+{
+public:
+    using lock_t = std::unique_lock<std::mutex>;
+
+    static constexpr std::size_t bucket_count = 256;
+
+    static parking_lot_t& instance()
+    {
+        static parking_lot_t lot;
+        return lot;
+    }
+
+    lock_t lock(void const* address)
+    {
+        return lock_t(bucket_for(address).m_mx);
+    }
+
+    // The following functions must be called with the lock of the address' bucket held.
+
+    // Blocks until another thread unparks this one and returns the token it has passed.
+    std::uintptr_t park(lock_t& lock, void const* address, std::uintptr_t token)
+    {
+        parked_thread_t thread { address, token, nullptr, false, {} };
+        enqueue(lock, thread, address);
+        thread.cv.wait(lock, [this, &thread]() { RENDEZVOUSCXX_INCREMENT_WAIT_COUNTER; return thread.is_unparked; });
+        return thread.token;
+    }
+
+    // Returns the first thread parked at the address, leaving it in the queue.
+    parked_thread_t* find(lock_t&, void const* address)
+    {
+        for (auto* thread = bucket_for(address).m_head; thread != nullptr; thread = thread->next)
+        {
+            if (thread->address == address)
+            {
+                return thread;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // Removes the first thread parked at the address from the queue without waking it up.
+    parked_thread_t* dequeue(lock_t& lock, void const* address)
+    {
+        auto* const thread = find(lock, address);
+        if (thread != nullptr)
+        {
+            remove(bucket_for(address), *thread);
+        }
+
+        return thread;
+    }
+
+    // Puts a dequeued but still sleeping thread to the end of the queue at another address.
+    void enqueue(lock_t&, parked_thread_t& thread, void const* address)
+    {
+        auto& bucket = bucket_for(address);
+        thread.address = address;
+        thread.next = nullptr;
+        if (bucket.m_tail == nullptr)
+        {
+            bucket.m_head = &thread;
+        }
+        else
+        {
+            bucket.m_tail->next = &thread;
+        }
+        bucket.m_tail = &thread;
+    }
+
+    // Wakes up a dequeued thread, which returns the token from park().
+    void unpark(lock_t&, parked_thread_t& thread, std::uintptr_t token)
+    {
+        thread.token = token;
+        thread.is_unparked = true;
+        thread.cv.notify_one();
+    }
+
+    std::size_t unpark_all(lock_t& lock, void const* address, std::uintptr_t token)
+    {
+        std::size_t count = 0;
+        while (auto* const thread = dequeue(lock, address))
+        {
+            unpark(lock, *thread, token);
+            ++count;
+        }
+
+        return count;
+    }
+
+    // Counts the waits of parked threads if built with RENDEZVOUSCXX_ENABLE_WAIT_COUNTER
+    // and stays zero otherwise. The member is there in either case, so that the
+    // global lot has the same layout in all translation units.
+    std::uint32_t wait_count() const { return m_wait_count; }
+
+private:
+    struct alignas(64) bucket_t
+    {
+        std::mutex m_mx;
+        parked_thread_t* m_head = nullptr;
+        parked_thread_t* m_tail = nullptr;
+    };
+
+    parking_lot_t() = default;
+
+    bucket_t& bucket_for(void const* address)
+    {
+        auto const word = reinterpret_cast<std::uintptr_t>(address) / sizeof(std::uintptr_t);
+        return m_buckets[std::hash<std::uintptr_t> {}(word) % bucket_count];
+    }
+
+    static void remove(bucket_t& bucket, parked_thread_t& thread)
+    {
+        parked_thread_t* previous = nullptr;
+        for (auto* current = bucket.m_head; current != &thread; current = current->next)
+        {
+            previous = current;
+        }
+
+        (previous == nullptr ? bucket.m_head : previous->next) = thread.next;
+        if (bucket.m_tail == &thread)
+        {
+            bucket.m_tail = previous;
+        }
+        thread.next = nullptr;
+    }
+
+    std::array<bucket_t, bucket_count> m_buckets;
+
+    std::atomic_uint32_t m_wait_count { 0 };
+};
+
+} // namespace detail
+
+} // namespace rendezvouscxx
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#define RENDEZVOUSCXX_CALL_SITE (::rendezvouscxx::call_site_t { __FILE__, __LINE__, nullptr })
+#define RENDEZVOUSCXX_CALL_SITE_TAG(tag) (::rendezvouscxx::call_site_t { __FILE__, __LINE__, (tag) })
+
+namespace rendezvouscxx
+{
+
+// Identifies the code that connects to a gate: either a source location
+// captured by RENDEZVOUSCXX_CALL_SITE or a caller-defined tag. Only the
+// pointers are kept until the session ends, so a tag must have static
+// storage duration, like a string literal or the __FILE__ name.
+struct call_site_t
+{
+    char const* file;
+    unsigned line;
+    char const* tag;
+
+    std::string label() const
+    {
+        if (tag != nullptr)
+        {
+            return tag;
+        }
+
+        if (file == nullptr)
+        {
+            return "<unknown>";
+        }
+
+        return std::string(file) + ":" + std::to_string(line);
+    }
+};
+
+struct call_site_stats_t
+{
+    std::string label;
+    std::uint64_t sample_count;
+    std::chrono::nanoseconds total_wait;
+    std::chrono::nanoseconds max_wait;
+    std::chrono::nanoseconds total_hold;
+    std::chrono::nanoseconds max_hold;
+};
+
+// Per-call-site table of the time clients spend waiting for a server and
+// holding it. Only every n-th connection is timed to keep the overhead low,
+// so the counts are the numbers of samples rather than of connections.
+class contention_profiler_t
+{
+public:
+    using clock_t = std::chrono::steady_clock;
+
+    explicit contention_profiler_t(std::uint32_t sampling_period = 1) :
+        m_sampling_period { std::max<std::uint32_t>(sampling_period, 1) },
+        m_connection_count { 0 }
+    {}
+
+    void set_sampling_period(std::uint32_t sampling_period)
+    {
+        m_sampling_period.store(std::max<std::uint32_t>(sampling_period, 1), std::memory_order_relaxed);
+    }
+
+    bool should_sample()
+    {
+        auto const count = m_connection_count.fetch_add(1, std::memory_order_relaxed);
+        return count % m_sampling_period.load(std::memory_order_relaxed) == 0;
+    }
+
+    void record(call_site_t const& site, std::chrono::nanoseconds wait, std::chrono::nanoseconds hold)
+    {
+        auto label = site.label();
+
+        std::unique_lock lock(m_mx);
+        auto& stats = m_table[label];
+        if (stats.sample_count == 0)
+        {
+            stats.label = std::move(label);
+        }
+
+        ++stats.sample_count;
+        stats.total_wait += wait;
+        stats.max_wait = std::max(stats.max_wait, wait);
+        stats.total_hold += hold;
+        stats.max_hold = std::max(stats.max_hold, hold);
+    }
+
+    // Call sites ordered by the total wait time, the hottest first.
+    std::vector<call_site_stats_t> snapshot() const
+    {
+        std::vector<call_site_stats_t> result;
+        {
+            std::unique_lock lock(m_mx);
+            for (auto const& [label, stats] : m_table)
+            {
+                result.push_back(stats);
+            }
+        }
+
+        std::sort(
+            result.begin(),
+            result.end(),
+            [](call_site_stats_t const& a, call_site_stats_t const& b) { return a.total_wait > b.total_wait; });
+
+        return result;
+    }
+
+    void dump(std::ostream& stream) const
+    {
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+
+        stream << "call site\tsamples\ttotal wait us\tmax wait us\ttotal hold us\tmax hold us\n";
+        for (auto const& stats : snapshot())
+        {
+            stream
+                << stats.label << '\t'
+                << stats.sample_count << '\t'
+                << duration_cast<microseconds>(stats.total_wait).count() << '\t'
+                << duration_cast<microseconds>(stats.max_wait).count() << '\t'
+                << duration_cast<microseconds>(stats.total_hold).count() << '\t'
+                << duration_cast<microseconds>(stats.max_hold).count() << '\n';
+        }
+    }
+
+    void reset()
+    {
+        std::unique_lock lock(m_mx);
+        m_table.clear();
+    }
+
+private:
+    std::atomic_uint32_t m_sampling_period;
+    std::atomic_uint64_t m_connection_count;
+    mutable std::mutex m_mx;
+    std::map<std::string, call_site_stats_t> m_table;
+};
+
+} // namespace rendezvouscxx
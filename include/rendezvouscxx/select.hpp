@@ -0,0 +1,136 @@
+#pragma once
+
+#include <rendezvouscxx/entry.hpp>
+#include <rendezvouscxx/trace.hpp>
+
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+
+namespace rendezvouscxx
+{
+
+// One branch of a selective accept: the body is run on a call to the entry,
+// but only while the guard holds. Clients calling the entry while the guard
+// is false stay parked in entry_t::call() until a later select() opens it.
+template <typename Guard, typename In, typename Out, typename Body>
+class alternative_t
+{
+public:
+    alternative_t(Guard guard, entry_t<In, Out>& entry, Body body) :
+        m_guard(std::move(guard)),
+        m_entry(entry),
+        m_body(std::move(body))
+    {}
+
+    bool is_open()
+    {
+        return m_guard();
+    }
+
+    detail::select_status_t try_accept(detail::selector_t& selector)
+    {
+        return m_entry.try_accept(selector, m_body);
+    }
+
+    void unregister_selector(detail::selector_t& selector)
+    {
+        m_entry.unregister_selector(selector);
+    }
+
+private:
+    Guard m_guard;
+    entry_t<In, Out>& m_entry;
+    Body m_body;
+};
+
+template <typename Guard, typename In, typename Out, typename Body>
+alternative_t<Guard, In, Out, Body> when(Guard guard, entry_t<In, Out>& entry, Body body)
+{
+    return alternative_t<Guard, In, Out, Body>(std::move(guard), entry, std::move(body));
+}
+
+// Selective accept: waits until some entry whose guard holds gets called and
+// runs the body of that alternative. The guards are evaluated when select()
+// starts and each time a client arrives at one of the open entries; earlier
+// alternatives win if several are callable at once. Returns false without
+// blocking if no alternative is open or all the open entries are closed.
+template <typename... Alternatives>
+bool select(Alternatives&&... alternatives)
+{
+    static_assert(sizeof...(Alternatives) > 0, "At least one alternative is required");
+
+    detail::selector_t selector;
+
+    for (;;)
+    {
+        {
+            std::unique_lock lock(selector.m_mx);
+            selector.m_is_signalled = false;
+        }
+
+        std::array<bool, sizeof...(Alternatives)> registrations {};
+
+        auto const unregister_all = [&selector, &registrations, &alternatives...]()
+        {
+            std::size_t index = 0;
+            ((registrations[index++] ? alternatives.unregister_selector(selector) : void()), ...);
+        };
+
+        auto const try_accept = [&selector](auto& alternative, bool& is_registered)
+        {
+            if (!alternative.is_open())
+            {
+                return false;
+            }
+
+            auto const status = alternative.try_accept(selector);
+            is_registered = status == detail::select_status_t::registered;
+            return status == detail::select_status_t::accepted;
+        };
+
+        bool is_accepted = false;
+        try
+        {
+            std::size_t index = 0;
+            is_accepted = (try_accept(alternatives, registrations[index++]) || ...);
+        }
+        catch (...)
+        {
+            unregister_all();
+            throw;
+        }
+
+        if (is_accepted)
+        {
+            RENDEZVOUSCXX_TRACE("select() has accepted a call");
+            unregister_all();
+            return true;
+        }
+
+        bool is_any_registered = false;
+        for (auto const is_registered : registrations)
+        {
+            is_any_registered = is_any_registered || is_registered;
+        }
+
+        if (!is_any_registered)
+        {
+            RENDEZVOUSCXX_TRACE("select() has no open entries");
+            return false;
+        }
+
+        RENDEZVOUSCXX_TRACE("select() waits for a call to an open entry");
+        {
+            std::unique_lock lock(selector.m_mx);
+            selector.m_cv.wait(
+                lock,
+                [&selector]() { return selector.m_is_signalled; });
+        }
+
+        unregister_all();
+    }
+}
+
+} // namespace rendezvouscxx
@@ -0,0 +1,31 @@
+#pragma once
+
+#ifdef RENDEZVOUSCXX_ENABLE_TRACE
+#include <iostream>
+#include <sstream>
+#include <thread>
+#define RENDEZVOUSCXX_TRACE(message) \
+    do \
+    { \
+        std::ostringstream stream; \
+        stream << "[RendesVousCxx] thread " << std::this_thread::get_id() << " " << message << std::endl; \
+        std::cout << stream.str(); \
+    } while (false)
+#else
+#define RENDEZVOUSCXX_TRACE(message) do {} while (false)
+#endif
+
+// Counts the evaluations of wait predicates, so that tests can tell a party
+// has got blocked. Expects the class to have an atomic m_wait_count member.
+#ifdef RENDEZVOUSCXX_ENABLE_WAIT_COUNTER
+#define RENDEZVOUSCXX_INCREMENT_WAIT_COUNTER (++m_wait_count, (void)0)
+#else
+#define RENDEZVOUSCXX_INCREMENT_WAIT_COUNTER ((void)0)
+#endif
+
+// Marks the places where a thread switch is the most likely to expose races.
+// A stress harness may define it before including the library to inject
+// deliberate preemptions; it expands to nothing by default.
+#ifndef RENDEZVOUSCXX_PREEMPTION_POINT
+#define RENDEZVOUSCXX_PREEMPTION_POINT() do {} while (false)
+#endif
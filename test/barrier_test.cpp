@@ -0,0 +1,124 @@
+#define RENDEZVOUSCXX_ENABLE_WAIT_COUNTER
+#include  <rendezvouscxx/barrier.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+// Runs the given number of phases on a group and checks that every participant
+// observes each completion exactly once and before leaving the barrier.
+void run_phases(std::size_t participant_count, int phase_count)
+{
+    std::atomic_int completion_count { 0 };
+    std::atomic_bool is_out_of_phase { false };
+
+    rendezvouscxx::barrier_t barrier(participant_count, [&completion_count]() { ++completion_count; });
+
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < participant_count; ++i)
+    {
+        threads.emplace_back([&barrier, &completion_count, &is_out_of_phase, i, phase_count]()
+        {
+            auto participant = barrier.participant(i);
+            for (int phase = 1; phase <= phase_count; ++phase)
+            {
+                if (!participant.arrive_and_wait() || completion_count != phase)
+                {
+                    is_out_of_phase = true;
+                }
+            }
+        });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK(completion_count == phase_count);
+    CHECK(!is_out_of_phase);
+}
+
+} // namespace
+
+TEST_CASE("A single participant completes each phase alone", "[RendezVousCxx]")
+{
+    run_phases(1, 10);
+}
+
+TEST_CASE("A small group of participants passes through phases", "[RendezVousCxx]")
+{
+    run_phases(6, 200);
+}
+
+TEST_CASE("A group wider than several tree levels passes through phases", "[RendezVousCxx]")
+{
+    run_phases(130, 20);
+}
+
+TEST_CASE("Participants wait for the rest, then the barrier closes", "[RendezVousCxx]")
+{
+    rendezvouscxx::barrier_t barrier(3);
+
+    std::atomic_int failure_count { 0 };
+    auto const participant_func = [&barrier, &failure_count](std::size_t index)
+    {
+        if (!barrier.participant(index).arrive_and_wait())
+        {
+            ++failure_count;
+        }
+    };
+
+    auto const old_wait_count = barrier.wait_count();
+    std::thread participant_thread_1 { participant_func, 0 };
+    std::thread participant_thread_2 { participant_func, 1 };
+
+    while (barrier.wait_count() != old_wait_count + 2)
+    {
+        std::this_thread::yield();
+    }
+
+    barrier.close();
+
+    participant_thread_1.join();
+    participant_thread_2.join();
+
+    CHECK(failure_count == 2);
+    CHECK(!barrier.arrive_and_wait(2));
+}
+
+TEST_CASE("The completion throws, then the barrier closes", "[RendezVousCxx]")
+{
+    rendezvouscxx::barrier_t barrier(2, []() { throw std::runtime_error("completion failed"); });
+
+    bool is_released = true;
+    auto const old_wait_count = barrier.wait_count();
+    std::thread participant_thread([&barrier, &is_released]() { is_released = barrier.arrive_and_wait(0); });
+
+    while (barrier.wait_count() == old_wait_count)
+    {
+        std::this_thread::yield();
+    }
+
+    CHECK_THROWS_AS(barrier.arrive_and_wait(1), std::runtime_error);
+
+    participant_thread.join();
+
+    CHECK(!is_released);
+    CHECK(!barrier.arrive_and_wait(0));
+}
+
+TEST_CASE("A participant index outside of the group is rejected", "[RendezVousCxx]")
+{
+    rendezvouscxx::barrier_t barrier(3);
+
+    CHECK_THROWS_AS(barrier.participant(3), std::out_of_range);
+    CHECK_THROWS_AS(barrier.arrive_and_wait(3), std::out_of_range);
+}
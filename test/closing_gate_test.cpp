@@ -31,10 +31,11 @@ void gate_closer(uint32_t old_counter, test_gate_t &gate)
     gate.close();
 }
 
-void close_gate_when_waiting(test_gate_t &gate)
+// The caller must join the thread before the gate goes out of scope:
+// close() may still be notifying when a waiting party has already returned.
+std::thread close_gate_when_waiting(test_gate_t &gate)
 {
-    std::thread closer_thread(gate_closer, gate.wait_count(), std::ref(gate));
-    closer_thread.detach();
+    return std::thread(gate_closer, gate.wait_count(), std::ref(gate));
 }
 
 }
@@ -67,9 +68,10 @@ TEST_CASE("One client tries to connect, then the gate closes", "[RendezVousCxx]"
     test_gate_t gate;
     auto client_gate = gate.client();
 
-    close_gate_when_waiting(gate);
+    auto closer_thread = close_gate_when_waiting(gate);
 
     auto const guard = client_gate.connect();
+    closer_thread.join();
     CHECK(!guard);
 }
 
@@ -78,10 +80,11 @@ TEST_CASE("One server tries to connect, then the gate closes", "[RendezVousCxx]"
     test_gate_t gate;
     auto server_gate = gate.server();
 
-    close_gate_when_waiting(gate);
+    auto closer_thread = close_gate_when_waiting(gate);
 
     test_server_t server;
     auto const is_connected = server_gate.connect(server);
+    closer_thread.join();
     CHECK(!is_connected);
 }
 
@@ -0,0 +1,197 @@
+#define RENDEZVOUSCXX_ENABLE_WAIT_COUNTER
+#include  <rendezvouscxx/compact_gate.hpp>
+#include  <rendezvouscxx/i_server.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+class i_test_server_t : public rendezvouscxx::i_server
+{
+public:
+    virtual void func() = 0;
+};
+
+class test_server_t : public i_test_server_t
+{
+public:
+    test_server_t() :
+        m_session_count { 0 },
+        m_call_count { 0 },
+        m_is_overlapped { false }
+    {}
+
+    int session_count() const { return m_session_count; }
+    int call_count() const { return m_call_count; }
+    bool is_overlapped() const { return m_is_overlapped; }
+
+private:
+    void on_client_connected() override
+    {
+        if (++m_session_count != m_call_count + 1)
+        {
+            m_is_overlapped = true;
+        }
+    }
+
+    void on_client_disconnecting() override {}
+
+    void func() override
+    {
+        ++m_call_count;
+    }
+
+    std::atomic_int m_session_count;
+    std::atomic_int m_call_count;
+    std::atomic_bool m_is_overlapped;
+};
+
+using test_gate_t = rendezvouscxx::compact_gate_t<i_test_server_t>;
+
+} // namespace
+
+TEST_CASE("A compact gate takes a single machine word", "[RendezVousCxx]")
+{
+    CHECK(sizeof(test_gate_t) == sizeof(std::uintptr_t));
+}
+
+TEST_CASE("Multiple clients connecting to multiple servers through a compact gate", "[RendezVousCxx]")
+{
+    test_gate_t gate;
+    test_server_t server;
+
+    auto const session_count = 100;
+
+    std::atomic_int failure_count { 0 };
+
+    auto const client_func = [&gate, &failure_count]()
+    {
+        for (int i = 0; i < session_count; ++i)
+        {
+            auto const guard = gate.client().connect();
+            if (!guard)
+            {
+                ++failure_count;
+                return;
+            }
+            guard->server().func();
+        }
+    };
+
+    auto const server_func = [&gate, &server, &failure_count]()
+    {
+        for (int i = 0; i < session_count; ++i)
+        {
+            if (!gate.server().connect(server))
+            {
+                ++failure_count;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i)
+    {
+        threads.emplace_back(client_func);
+        threads.emplace_back(server_func);
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    CHECK(failure_count == 0);
+    CHECK(server.session_count() == 3 * session_count);
+    CHECK(server.call_count() == 3 * session_count);
+    CHECK(!server.is_overlapped());
+}
+
+TEST_CASE("Many compact gates serving a client each", "[RendezVousCxx]")
+{
+    std::vector<test_gate_t> gates(1000);
+    test_server_t server;
+
+    bool is_client_failed = false;
+    std::thread client_thread([&gates, &is_client_failed]()
+    {
+        for (auto& gate : gates)
+        {
+            auto const guard = gate.client().connect();
+            if (!guard)
+            {
+                is_client_failed = true;
+                return;
+            }
+            guard->server().func();
+        }
+    });
+
+    for (auto& gate : gates)
+    {
+        CHECK(gate.server().connect(server));
+    }
+
+    client_thread.join();
+
+    CHECK(!is_client_failed);
+    CHECK(server.call_count() == 1000);
+}
+
+TEST_CASE("The compact gate closes, then a client and a server try to connect", "[RendezVousCxx]")
+{
+    test_gate_t gate;
+    test_server_t server;
+
+    gate.close();
+
+    CHECK(!gate.client().connect());
+    CHECK(!gate.server().connect(server));
+}
+
+TEST_CASE("A client and a server wait on separate compact gates, then the gates close", "[RendezVousCxx]")
+{
+    test_gate_t client_gate;
+    test_gate_t server_gate;
+    test_server_t server;
+
+    bool is_client_connected = true;
+    bool is_server_connected = true;
+
+    auto const wait_until_parked = [](test_gate_t const& gate, std::uint32_t old_wait_count)
+    {
+        while (gate.wait_count() == old_wait_count)
+        {
+            std::this_thread::yield();
+        }
+    };
+
+    auto old_wait_count = client_gate.wait_count();
+    std::thread client_thread([&client_gate, &is_client_connected]()
+    {
+        is_client_connected = client_gate.client().connect() != nullptr;
+    });
+    wait_until_parked(client_gate, old_wait_count);
+
+    old_wait_count = server_gate.wait_count();
+    std::thread server_thread([&server_gate, &server, &is_server_connected]()
+    {
+        is_server_connected = server_gate.server().connect(server);
+    });
+    wait_until_parked(server_gate, old_wait_count);
+
+    client_gate.close();
+    server_gate.close();
+
+    client_thread.join();
+    server_thread.join();
+
+    CHECK(!is_client_connected);
+    CHECK(!is_server_connected);
+}
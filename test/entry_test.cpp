@@ -0,0 +1,144 @@
+#define RENDEZVOUSCXX_ENABLE_WAIT_COUNTER
+#include  <rendezvouscxx/entry.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+using test_entry_t = rendezvouscxx::entry_t<std::string, std::vector<int>>;
+
+} // namespace
+
+TEST_CASE("The accept body runs on the client's buffers", "[RendezVousCxx]")
+{
+    test_entry_t entry;
+
+    std::string const in { "abc" };
+    std::vector<int> out;
+    std::string const* seen_in = nullptr;
+    std::vector<int>* seen_out = nullptr;
+    bool is_accepted = false;
+
+    std::thread server_thread([&entry, &seen_in, &seen_out, &is_accepted]()
+    {
+        is_accepted = rendezvouscxx::accept(entry, [&seen_in, &seen_out](std::string const& in, std::vector<int>& out)
+        {
+            seen_in = &in;
+            seen_out = &out;
+            for (auto const c : in)
+            {
+                out.push_back(c - 'a');
+            }
+        });
+    });
+
+    auto const is_called = entry.client().call(in, out);
+
+    server_thread.join();
+
+    CHECK(is_accepted);
+    CHECK(is_called);
+    CHECK(seen_in == &in);
+    CHECK(seen_out == &out);
+    CHECK(out == std::vector<int> { 0, 1, 2 });
+}
+
+TEST_CASE("Multiple clients calling an entry accepted by a single server thread", "[RendezVousCxx]")
+{
+    rendezvouscxx::entry_t<int, int> entry;
+
+    auto const client_func = [&entry](int in, int& out, bool& is_called)
+    {
+        is_called = entry.client().call(in, out);
+    };
+
+    int out_1 = 0;
+    int out_2 = 0;
+    int out_3 = 0;
+    bool is_called_1 = false;
+    bool is_called_2 = false;
+    bool is_called_3 = false;
+
+    std::thread client_thread_1 { client_func, 1, std::ref(out_1), std::ref(is_called_1) };
+    std::thread client_thread_2 { client_func, 2, std::ref(out_2), std::ref(is_called_2) };
+    std::thread client_thread_3 { client_func, 3, std::ref(out_3), std::ref(is_called_3) };
+
+    auto server_entry = entry.server();
+    for (int i = 0; i < 3; ++i)
+    {
+        CHECK(server_entry.accept([](int const& in, int& out) { out = in * 10; }));
+    }
+
+    client_thread_1.join();
+    client_thread_2.join();
+    client_thread_3.join();
+
+    CHECK(is_called_1);
+    CHECK(is_called_2);
+    CHECK(is_called_3);
+    CHECK(out_1 == 10);
+    CHECK(out_2 == 20);
+    CHECK(out_3 == 30);
+}
+
+TEST_CASE("The entry closes, then a client calls and a server accepts", "[RendezVousCxx]")
+{
+    rendezvouscxx::entry_t<int, int> entry;
+
+    entry.close();
+
+    int out = 0;
+    CHECK(!entry.call(1, out));
+    CHECK(!entry.accept([](int const&, int&) {}));
+}
+
+TEST_CASE("A client waits for an entry, then the entry closes", "[RendezVousCxx]")
+{
+    rendezvouscxx::entry_t<int, int> entry;
+
+    int out = 0;
+    bool is_called = true;
+    auto const old_wait_count = entry.wait_count();
+    std::thread client_thread([&entry, &out, &is_called]() { is_called = entry.call(1, out); });
+
+    while (entry.wait_count() == old_wait_count)
+    {
+        std::this_thread::yield();
+    }
+
+    entry.close();
+    client_thread.join();
+
+    CHECK(!is_called);
+}
+
+TEST_CASE("An exception in the accept body propagates to both parties", "[RendezVousCxx]")
+{
+    rendezvouscxx::entry_t<int, int> entry;
+
+    bool is_server_thrown = false;
+    std::thread server_thread([&entry, &is_server_thrown]()
+    {
+        try
+        {
+            entry.accept([](int const&, int&) { throw std::runtime_error("accept body failed"); });
+        }
+        catch (std::runtime_error const&)
+        {
+            is_server_thrown = true;
+        }
+    });
+
+    int out = 0;
+    CHECK_THROWS_AS(entry.call(1, out), std::runtime_error);
+
+    server_thread.join();
+
+    CHECK(is_server_thrown);
+}
@@ -0,0 +1,104 @@
+#define RENDEZVOUSCXX_ENABLE_WAIT_COUNTER
+#include  <rendezvouscxx/exchanger.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST_CASE("Two parties swap their values without copying", "[RendezVousCxx]")
+{
+    rendezvouscxx::exchanger_t<std::vector<int>> exchanger;
+
+    std::vector<int> producer_buffer { 1, 2, 3 };
+    std::vector<int> consumer_buffer { 4, 5 };
+
+    auto const* const producer_data = producer_buffer.data();
+    auto const* const consumer_data = consumer_buffer.data();
+
+    bool is_producer_exchanged = false;
+    std::thread producer_thread([&exchanger, &producer_buffer, &is_producer_exchanged]()
+    {
+        is_producer_exchanged = exchanger.party().exchange(producer_buffer);
+    });
+
+    CHECK(exchanger.party().exchange(consumer_buffer));
+
+    producer_thread.join();
+
+    CHECK(is_producer_exchanged);
+    CHECK(producer_buffer == std::vector<int> { 4, 5 });
+    CHECK(consumer_buffer == std::vector<int> { 1, 2, 3 });
+    CHECK(producer_buffer.data() == consumer_data);
+    CHECK(consumer_buffer.data() == producer_data);
+}
+
+TEST_CASE("A double-buffered pipeline exchanging move-only values", "[RendezVousCxx]")
+{
+    rendezvouscxx::exchanger_t<std::unique_ptr<int>> exchanger;
+
+    auto const round_count = 1000;
+
+    bool is_producer_failed = false;
+    std::thread producer_thread([&exchanger, &is_producer_failed]()
+    {
+        auto party = exchanger.party();
+        auto buffer = std::make_unique<int>(0);
+        for (int i = 1; i <= round_count; ++i)
+        {
+            *buffer = i;
+            if (!party.exchange(buffer))
+            {
+                is_producer_failed = true;
+                return;
+            }
+        }
+    });
+
+    auto party = exchanger.party();
+    auto buffer = std::make_unique<int>(0);
+    long sum = 0;
+    for (int i = 1; i <= round_count; ++i)
+    {
+        CHECK(party.exchange(buffer));
+        sum += *buffer;
+    }
+
+    producer_thread.join();
+
+    CHECK(!is_producer_failed);
+    CHECK(sum == long { round_count } * (round_count + 1) / 2);
+}
+
+TEST_CASE("The exchanger closes, then a party tries to exchange", "[RendezVousCxx]")
+{
+    rendezvouscxx::exchanger_t<int> exchanger;
+
+    exchanger.close();
+
+    int value = 1;
+    CHECK(!exchanger.exchange(value));
+    CHECK(value == 1);
+}
+
+TEST_CASE("A party waits for the other one, then the exchanger closes", "[RendezVousCxx]")
+{
+    rendezvouscxx::exchanger_t<int> exchanger;
+
+    int value = 1;
+    bool is_exchanged = true;
+    auto const old_wait_count = exchanger.wait_count();
+    std::thread party_thread([&exchanger, &value, &is_exchanged]() { is_exchanged = exchanger.exchange(value); });
+
+    while (exchanger.wait_count() == old_wait_count)
+    {
+        std::this_thread::yield();
+    }
+
+    exchanger.close();
+    party_thread.join();
+
+    CHECK(!is_exchanged);
+    CHECK(value == 1);
+}
@@ -0,0 +1,218 @@
+#define RENDEZVOUSCXX_ENABLE_WAIT_COUNTER
+#include  <rendezvouscxx.hpp>
+#include  <rendezvouscxx/i_server.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+namespace
+{
+
+class i_test_server_t : public rendezvouscxx::i_server
+{
+public:
+    virtual int id() const = 0;
+};
+
+class test_server_t : public i_test_server_t
+{
+public:
+    explicit test_server_t(int id) :
+        m_id { id },
+        m_disconnecting_count { 0 },
+        m_lease_expiry_count { 0 }
+    {}
+
+    int disconnecting_count() const { return m_disconnecting_count; }
+    int lease_expiry_count() const { return m_lease_expiry_count; }
+
+private:
+    void on_client_connected() override {}
+    void on_client_disconnecting() override { ++m_disconnecting_count; }
+    void on_lease_expired() override { ++m_lease_expiry_count; }
+    int id() const override { return m_id; }
+
+    int const m_id;
+    std::atomic_int m_disconnecting_count;
+    std::atomic_int m_lease_expiry_count;
+};
+
+using test_gate_t = rendezvouscxx::gate_t<i_test_server_t>;
+
+} // namespace
+
+TEST_CASE("A client holding the session past its lease gets revoked", "[RendezVousCxx]")
+{
+    test_gate_t gate;
+    test_server_t server_1 { 1 };
+    test_server_t server_2 { 2 };
+
+    bool is_server_1_connected = false;
+    bool is_server_2_connected = false;
+    std::thread server_thread([&gate, &server_1, &server_2, &is_server_1_connected, &is_server_2_connected]()
+    {
+        is_server_1_connected = gate.server().connect(server_1);
+        is_server_2_connected = gate.server().connect(server_2);
+    });
+
+    auto const slow_guard = gate.client().connect(std::chrono::milliseconds(20));
+    REQUIRE(slow_guard);
+    CHECK(slow_guard->server().id() == 1);
+
+    {
+        auto const guard = gate.client().connect();
+        REQUIRE(guard);
+        CHECK(guard->server().id() == 2);
+        CHECK(slow_guard->is_revoked());
+        CHECK_THROWS_AS(slow_guard->server(), rendezvouscxx::session_revoked_error);
+    }
+
+    server_thread.join();
+
+    CHECK(is_server_1_connected);
+    CHECK(is_server_2_connected);
+    CHECK(server_1.lease_expiry_count() == 1);
+    CHECK(server_1.disconnecting_count() == 0);
+    CHECK(server_2.lease_expiry_count() == 0);
+    CHECK(server_2.disconnecting_count() == 1);
+
+    auto const stats = gate.stats();
+    CHECK(stats.session_count == 2);
+    CHECK(stats.lease_expiry_count == 1);
+}
+
+TEST_CASE("A client disconnecting within its lease is not revoked", "[RendezVousCxx]")
+{
+    test_gate_t gate;
+    test_server_t server { 1 };
+
+    bool is_server_connected = false;
+    std::thread server_thread([&gate, &server, &is_server_connected]()
+    {
+        is_server_connected = gate.server().connect(server);
+    });
+
+    {
+        auto const guard = gate.client().connect(std::chrono::minutes(1));
+        REQUIRE(guard);
+        CHECK(guard->server().id() == 1);
+        CHECK(!guard->is_revoked());
+    }
+
+    server_thread.join();
+
+    CHECK(is_server_connected);
+    CHECK(server.lease_expiry_count() == 0);
+    CHECK(server.disconnecting_count() == 1);
+    CHECK(gate.stats().lease_expiry_count == 0);
+}
+
+TEST_CASE("A client connecting without a lease is revoked on the server's lease", "[RendezVousCxx]")
+{
+    test_gate_t gate;
+    test_server_t server { 1 };
+
+    bool is_server_connected = false;
+    std::thread server_thread([&gate, &server, &is_server_connected]()
+    {
+        is_server_connected = gate.server().connect(server, std::chrono::milliseconds(20));
+    });
+
+    auto const guard = gate.client().connect();
+    REQUIRE(guard);
+
+    server_thread.join();
+
+    CHECK(is_server_connected);
+    CHECK(guard->is_revoked());
+    CHECK_THROWS_AS(guard->server(), rendezvouscxx::session_revoked_error);
+    CHECK(server.lease_expiry_count() == 1);
+    CHECK(server.disconnecting_count() == 0);
+}
+
+TEST_CASE("A client's lease shortens the server's lease", "[RendezVousCxx]")
+{
+    test_gate_t gate;
+    test_server_t server { 1 };
+
+    bool is_server_connected = false;
+    std::thread server_thread([&gate, &server, &is_server_connected]()
+    {
+        is_server_connected = gate.server().connect(server, std::chrono::minutes(1));
+    });
+
+    auto const guard = gate.client().connect(std::chrono::milliseconds(20));
+    REQUIRE(guard);
+
+    server_thread.join();
+
+    CHECK(is_server_connected);
+    CHECK(guard->is_revoked());
+    CHECK(server.lease_expiry_count() == 1);
+}
+
+TEST_CASE("A lease too long to add to the current time never expires", "[RendezVousCxx]")
+{
+    test_gate_t gate;
+    test_server_t server { 1 };
+
+    bool is_server_connected = false;
+    std::thread server_thread([&gate, &server, &is_server_connected]()
+    {
+        is_server_connected = gate.server().connect(server, rendezvouscxx::lease_duration_t::max());
+    });
+
+    {
+        auto const guard = gate.client().connect(std::chrono::hours::max());
+        REQUIRE(guard);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        CHECK(!guard->is_revoked());
+    }
+
+    server_thread.join();
+
+    CHECK(is_server_connected);
+    CHECK(server.lease_expiry_count() == 0);
+    CHECK(server.disconnecting_count() == 1);
+}
+
+TEST_CASE("The gate closes during a session without lease while another client waits", "[RendezVousCxx]")
+{
+    test_gate_t gate;
+    test_server_t server { 1 };
+
+    bool is_server_connected = false;
+    std::thread server_thread([&gate, &server, &is_server_connected]()
+    {
+        is_server_connected = gate.server().connect(server);
+    });
+
+    auto const guard = gate.client().connect();
+    REQUIRE(guard);
+
+    auto const old_wait_count = gate.wait_count();
+    bool is_waiting_client_connected = true;
+    std::thread waiting_client_thread([&gate, &is_waiting_client_connected]()
+    {
+        is_waiting_client_connected = gate.client().connect() != nullptr;
+    });
+
+    while (gate.wait_count() == old_wait_count)
+    {
+        std::this_thread::yield();
+    }
+
+    gate.close();
+
+    waiting_client_thread.join();
+    server_thread.join();
+
+    CHECK(!is_waiting_client_connected);
+    CHECK(is_server_connected);
+    CHECK(!guard->is_revoked());
+    CHECK_NOTHROW(guard->server().id());
+    CHECK(server.lease_expiry_count() == 0);
+}
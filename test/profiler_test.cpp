@@ -0,0 +1,140 @@
+#define RENDEZVOUSCXX_ENABLE_PROFILER
+#define RENDEZVOUSCXX_ENABLE_WAIT_COUNTER
+#include  <rendezvouscxx.hpp>
+
+#include  <rendezvouscxx/i_server.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <sstream>
+#include <thread>
+
+namespace
+{
+
+class i_test_server_t : public rendezvouscxx::i_server
+{};
+
+class test_server_t : public i_test_server_t
+{
+private:
+    void on_client_connected() override {}
+    void on_client_disconnecting() override {}
+};
+
+using test_gate_t = rendezvouscxx::gate_t<i_test_server_t>;
+
+void serve(test_gate_t& gate, int session_count)
+{
+    test_server_t server;
+    for (int i = 0; i < session_count; ++i)
+    {
+        gate.server().connect(server);
+    }
+}
+
+} // namespace
+
+TEST_CASE("The profiler attributes wait and hold times to call sites", "[RendezVousCxx]")
+{
+    test_gate_t gate;
+
+    std::thread server_thread(serve, std::ref(gate), 3);
+
+    {
+        auto const guard = gate.client().connect(RENDEZVOUSCXX_CALL_SITE_TAG("slow"));
+        REQUIRE(guard);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    for (int i = 0; i < 2; ++i)
+    {
+        auto const guard = gate.client().connect(RENDEZVOUSCXX_CALL_SITE);
+        REQUIRE(guard);
+    }
+
+    server_thread.join();
+
+    auto const table = gate.profiler().snapshot();
+    REQUIRE(table.size() == 2);
+
+    auto const& slow = table[0].label == "slow" ? table[0] : table[1];
+    auto const& fast = table[0].label == "slow" ? table[1] : table[0];
+
+    CHECK(slow.label == "slow");
+    CHECK(slow.sample_count == 1);
+    CHECK(slow.total_hold >= std::chrono::milliseconds(20));
+    CHECK(slow.max_hold == slow.total_hold);
+    CHECK(fast.label.find("profiler_test.cpp:") != std::string::npos);
+    CHECK(fast.sample_count == 2);
+
+    std::ostringstream dump;
+    gate.profiler().dump(dump);
+    CHECK(dump.str().find("slow\t1\t") != std::string::npos);
+}
+
+TEST_CASE("The profiler attributes the wait behind another session to the waiting call site", "[RendezVousCxx]")
+{
+    test_gate_t gate;
+
+    std::thread server_thread(serve, std::ref(gate), 2);
+
+    auto const hold_time = std::chrono::milliseconds(20);
+    {
+        auto guard = gate.client().connect(RENDEZVOUSCXX_CALL_SITE_TAG("holding"));
+        REQUIRE(guard);
+
+        auto const old_wait_count = gate.wait_count();
+        bool is_connected = false;
+        std::thread waiting_client_thread([&gate, &is_connected]()
+        {
+            is_connected = gate.client().connect(RENDEZVOUSCXX_CALL_SITE_TAG("waiting")) != nullptr;
+        });
+
+        while (gate.wait_count() == old_wait_count)
+        {
+            std::this_thread::yield();
+        }
+
+        std::this_thread::sleep_for(hold_time);
+        guard.reset();
+
+        waiting_client_thread.join();
+        CHECK(is_connected);
+    }
+
+    server_thread.join();
+
+    auto const table = gate.profiler().snapshot();
+    REQUIRE(table.size() == 2);
+
+    auto const& waiting = table[0].label == "waiting" ? table[0] : table[1];
+    CHECK(waiting.label == "waiting");
+    CHECK(waiting.sample_count == 1);
+    CHECK(waiting.max_wait >= hold_time);
+    CHECK(waiting.total_wait == waiting.max_wait);
+}
+
+TEST_CASE("The profiler samples every n-th connection", "[RendezVousCxx]")
+{
+    test_gate_t gate;
+    gate.profiler().set_sampling_period(2);
+
+    std::thread server_thread(serve, std::ref(gate), 4);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        auto const guard = gate.client().connect(RENDEZVOUSCXX_CALL_SITE_TAG("sampled"));
+        REQUIRE(guard);
+    }
+
+    server_thread.join();
+
+    auto const table = gate.profiler().snapshot();
+    REQUIRE(table.size() == 1);
+    CHECK(table[0].sample_count == 2);
+
+    gate.profiler().reset();
+    CHECK(gate.profiler().snapshot().empty());
+}
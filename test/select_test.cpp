@@ -0,0 +1,181 @@
+#define RENDEZVOUSCXX_ENABLE_WAIT_COUNTER
+#include  <rendezvouscxx/select.hpp>
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <deque>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace
+{
+
+using put_entry_t = rendezvouscxx::entry_t<int, std::monostate>;
+using get_entry_t = rendezvouscxx::entry_t<std::monostate, int>;
+
+class bounded_buffer_t
+{
+public:
+    explicit bounded_buffer_t(std::size_t capacity) :
+        m_capacity { capacity },
+        m_max_size { 0 }
+    {}
+
+    bool serve_one()
+    {
+        return rendezvouscxx::select(
+            rendezvouscxx::when(
+                [this]() { return m_items.size() < m_capacity; },
+                m_put,
+                [this](int const& item, std::monostate&)
+                {
+                    m_items.push_back(item);
+                    m_max_size = std::max(m_max_size, m_items.size());
+                }),
+            rendezvouscxx::when(
+                [this]() { return !m_items.empty(); },
+                m_get,
+                [this](std::monostate const&, int& item)
+                {
+                    item = m_items.front();
+                    m_items.pop_front();
+                }));
+    }
+
+    put_entry_t& put() { return m_put; }
+    get_entry_t& get() { return m_get; }
+    std::size_t max_size() const { return m_max_size; }
+
+private:
+    put_entry_t m_put;
+    get_entry_t m_get;
+    std::deque<int> m_items;
+    std::size_t const m_capacity;
+    std::size_t m_max_size;
+};
+
+} // namespace
+
+TEST_CASE("A bounded buffer accepts put only while not full and get only while not empty", "[RendezVousCxx]")
+{
+    bounded_buffer_t buffer { 2 };
+
+    auto const item_count = 20;
+
+    bool is_put_failed = false;
+    std::thread producer_thread([&buffer, &is_put_failed]()
+    {
+        auto put = buffer.put().client();
+        for (int i = 0; i < item_count; ++i)
+        {
+            std::monostate none;
+            is_put_failed = !put.call(i, none) || is_put_failed;
+        }
+    });
+
+    bool is_get_failed = false;
+    std::vector<int> received;
+    std::thread consumer_thread([&buffer, &received, &is_get_failed]()
+    {
+        auto get = buffer.get().client();
+        for (int i = 0; i < item_count; ++i)
+        {
+            int item = -1;
+            is_get_failed = !get.call(std::monostate {}, item) || is_get_failed;
+            received.push_back(item);
+        }
+    });
+
+    for (int i = 0; i < 2 * item_count; ++i)
+    {
+        CHECK(buffer.serve_one());
+    }
+
+    producer_thread.join();
+    consumer_thread.join();
+
+    CHECK(!is_put_failed);
+    CHECK(!is_get_failed);
+
+    std::vector<int> expected;
+    for (int i = 0; i < item_count; ++i)
+    {
+        expected.push_back(i);
+    }
+
+    CHECK(received == expected);
+    CHECK(buffer.max_size() <= 2);
+}
+
+TEST_CASE("A client of a closed alternative waits until the guard opens", "[RendezVousCxx]")
+{
+    bounded_buffer_t buffer { 1 };
+
+    int item = -1;
+    bool is_got = false;
+    auto const old_wait_count = buffer.get().wait_count();
+    std::thread consumer_thread([&buffer, &item, &is_got]()
+    {
+        is_got = buffer.get().call(std::monostate {}, item);
+    });
+
+    while (buffer.get().wait_count() == old_wait_count)
+    {
+        std::this_thread::yield();
+    }
+
+    bool is_put = false;
+    std::thread producer_thread([&buffer, &is_put]()
+    {
+        std::monostate none;
+        is_put = buffer.put().call(42, none);
+    });
+
+    // The get call is pending already, but the empty buffer can only accept put.
+    CHECK(buffer.serve_one());
+    CHECK(buffer.max_size() == 1);
+    CHECK(buffer.serve_one());
+
+    producer_thread.join();
+    consumer_thread.join();
+
+    CHECK(is_put);
+    CHECK(is_got);
+    CHECK(item == 42);
+}
+
+TEST_CASE("Selecting with no open alternatives fails immediately", "[RendezVousCxx]")
+{
+    put_entry_t entry;
+
+    auto const is_accepted = rendezvouscxx::select(
+        rendezvouscxx::when([]() { return false; }, entry, [](int const&, std::monostate&) {}));
+
+    CHECK(!is_accepted);
+}
+
+TEST_CASE("A server selects on an entry, then the entry closes", "[RendezVousCxx]")
+{
+    put_entry_t entry;
+
+    bool is_accepted = true;
+    auto const old_wait_count = entry.wait_count();
+    std::thread server_thread([&entry, &is_accepted]()
+    {
+        is_accepted = rendezvouscxx::select(
+            rendezvouscxx::when([]() { return true; }, entry, [](int const&, std::monostate&) {}));
+    });
+
+    while (entry.wait_count() == old_wait_count)
+    {
+        std::this_thread::yield();
+    }
+
+    entry.close();
+    server_thread.join();
+
+    CHECK(!is_accepted);
+}
@@ -0,0 +1,330 @@
+// Contention stress harness for the gates.
+//
+// Replays seeded random schedules of connects, disconnects and closes across
+// many client and server threads, with deliberate preemptions injected both
+// into the schedules and into the gates through RENDEZVOUSCXX_PREEMPTION_POINT.
+// The decisions of every thread are a pure function of the seed, so a failing
+// seed can be replayed, although the OS is still free to interleave threads.
+//
+// Reports sessions per second and the p99 time clients wait for a server,
+// checks invariants such as no overlapping sessions, and fails if a throughput
+// or latency threshold given on the command line is not met.
+
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <thread>
+
+namespace stress
+{
+
+thread_local std::minstd_rand t_preemption_rng { 1 };
+
+void seed_preemptions(std::uint64_t seed)
+{
+    t_preemption_rng.seed(static_cast<std::minstd_rand::result_type>(seed % 2147483647 + 1));
+}
+
+void preemption_point()
+{
+    auto const dice = t_preemption_rng() % 64;
+    if (dice == 0)
+    {
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    else if (dice < 16)
+    {
+        std::this_thread::yield();
+    }
+}
+
+} // namespace stress
+
+#define RENDEZVOUSCXX_PREEMPTION_POINT() ::stress::preemption_point()
+
+#include <rendezvouscxx.hpp>
+#include <rendezvouscxx/compact_gate.hpp>
+#include <rendezvouscxx/i_server.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+using clock_type = std::chrono::steady_clock;
+
+struct options_t
+{
+    std::string gate = "all";
+    std::uint64_t seed = 1;
+    int round_count = 20;
+    int client_count = 8;
+    int server_count = 4;
+    int sessions_per_client = 200;
+    double min_sessions_per_second = 0;
+    double max_p99_wait_us = 0;
+};
+
+struct result_t
+{
+    std::uint64_t session_count = 0;
+    std::uint64_t violation_count = 0;
+    std::chrono::nanoseconds elapsed {};
+    std::vector<std::chrono::nanoseconds> waits;
+};
+
+class i_stress_server_t : public rendezvouscxx::i_server
+{
+public:
+    virtual void touch() = 0;
+};
+
+class stress_server_t : public i_stress_server_t
+{
+public:
+    explicit stress_server_t(std::atomic_int& active_session_count, std::atomic_uint64_t& violation_count) :
+        m_active_session_count(active_session_count),
+        m_violation_count(violation_count)
+    {}
+
+private:
+    void on_client_connected() override
+    {
+        if (++m_active_session_count != 1)
+        {
+            ++m_violation_count;
+        }
+    }
+
+    void on_client_disconnecting() override
+    {
+        if (--m_active_session_count != 0)
+        {
+            ++m_violation_count;
+        }
+    }
+
+    void touch() override
+    {
+        if (m_active_session_count != 1)
+        {
+            ++m_violation_count;
+        }
+    }
+
+    std::atomic_int& m_active_session_count;
+    std::atomic_uint64_t& m_violation_count;
+};
+
+// One round: a fresh gate, clients running their schedules, servers serving
+// until the gate closes, and a closer closing it at a seeded random moment.
+template <typename Gate>
+void run_round(options_t const& options, std::uint64_t round_seed, result_t& result)
+{
+    Gate gate;
+    std::atomic_int active_session_count { 0 };
+    std::atomic_uint64_t violation_count { 0 };
+    std::atomic_uint64_t session_count { 0 };
+    std::vector<std::vector<std::chrono::nanoseconds>> waits(options.client_count);
+
+    std::mt19937_64 round_rng { round_seed };
+    auto const total_sessions = std::uint64_t(options.client_count) * options.sessions_per_client;
+    auto const is_closed_early = round_rng() % 2 == 0;
+    auto const close_after = is_closed_early ? round_rng() % (total_sessions + 1) : total_sessions;
+
+    std::vector<std::thread> server_threads;
+    std::vector<stress_server_t> servers;
+    servers.reserve(options.server_count);
+    for (int i = 0; i < options.server_count; ++i)
+    {
+        servers.emplace_back(active_session_count, violation_count);
+        server_threads.emplace_back([&gate, &server = servers.back(), seed = round_rng()]()
+        {
+            stress::seed_preemptions(seed);
+            while (gate.server().connect(server))
+            {
+                stress::preemption_point();
+            }
+        });
+    }
+
+    auto const started = clock_type::now();
+
+    std::vector<std::thread> client_threads;
+    for (int i = 0; i < options.client_count; ++i)
+    {
+        client_threads.emplace_back([&, &client_waits = waits[i], seed = round_rng()]()
+        {
+            stress::seed_preemptions(seed);
+            std::mt19937_64 rng { seed };
+            for (int j = 0; j < options.sessions_per_client; ++j)
+            {
+                auto const connecting = clock_type::now();
+                auto const guard = gate.client().connect();
+                if (!guard)
+                {
+                    return;
+                }
+
+                client_waits.push_back(clock_type::now() - connecting);
+                ++session_count;
+
+                for (auto call_count = rng() % 4; call_count > 0; --call_count)
+                {
+                    guard->server().touch();
+                    stress::preemption_point();
+                }
+            }
+        });
+    }
+
+    std::thread closer_thread([&gate, &session_count, close_after, seed = round_rng()]()
+    {
+        stress::seed_preemptions(seed);
+        while (session_count < close_after)
+        {
+            stress::preemption_point();
+            std::this_thread::yield();
+        }
+
+        gate.close();
+    });
+
+    for (auto& thread : client_threads)
+    {
+        thread.join();
+    }
+
+    auto const finished = clock_type::now();
+
+    closer_thread.join();
+    for (auto& thread : server_threads)
+    {
+        thread.join();
+    }
+
+    if (gate.client().connect())
+    {
+        ++violation_count;
+    }
+
+    if (active_session_count != 0)
+    {
+        ++violation_count;
+    }
+
+    result.session_count += session_count;
+    result.violation_count += violation_count;
+    result.elapsed += finished - started;
+    for (auto const& client_waits : waits)
+    {
+        result.waits.insert(result.waits.end(), client_waits.begin(), client_waits.end());
+    }
+}
+
+template <typename Gate>
+bool run(std::string const& name, options_t const& options)
+{
+    result_t result;
+    for (int round = 0; round < options.round_count; ++round)
+    {
+        run_round<Gate>(options, options.seed * 1000003 + round, result);
+    }
+
+    double p99_wait_us = 0;
+    if (!result.waits.empty())
+    {
+        auto const p99 = result.waits.begin() + (result.waits.size() - 1) * 99 / 100;
+        std::nth_element(result.waits.begin(), p99, result.waits.end());
+        p99_wait_us = std::chrono::duration<double, std::micro>(*p99).count();
+    }
+
+    auto const seconds = std::chrono::duration<double>(result.elapsed).count();
+    auto const sessions_per_second = seconds > 0 ? result.session_count / seconds : 0;
+
+    std::cout
+        << name
+        << ": seed " << options.seed
+        << ", sessions " << result.session_count
+        << ", sessions/s " << sessions_per_second
+        << ", p99 wait us " << p99_wait_us
+        << ", violations " << result.violation_count
+        << std::endl;
+
+    bool is_passed = true;
+    if (result.violation_count != 0)
+    {
+        std::cout << name << ": FAILED, invariants violated" << std::endl;
+        is_passed = false;
+    }
+
+    if (options.min_sessions_per_second > 0 && sessions_per_second < options.min_sessions_per_second)
+    {
+        std::cout << name << ": FAILED, throughput below " << options.min_sessions_per_second << " sessions/s" << std::endl;
+        is_passed = false;
+    }
+
+    if (options.max_p99_wait_us > 0 && p99_wait_us > options.max_p99_wait_us)
+    {
+        std::cout << name << ": FAILED, p99 wait above " << options.max_p99_wait_us << " us" << std::endl;
+        is_passed = false;
+    }
+
+    return is_passed;
+}
+
+bool parse(int argc, char* argv[], options_t& options)
+{
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string const key = argv[i];
+        std::string const value = argv[i + 1];
+
+        if (key == "--gate") options.gate = value;
+        else if (key == "--seed") options.seed = std::stoull(value);
+        else if (key == "--rounds") options.round_count = std::stoi(value);
+        else if (key == "--clients") options.client_count = std::stoi(value);
+        else if (key == "--servers") options.server_count = std::stoi(value);
+        else if (key == "--sessions") options.sessions_per_client = std::stoi(value);
+        else if (key == "--min-sessions-per-second") options.min_sessions_per_second = std::stod(value);
+        else if (key == "--max-p99-wait-us") options.max_p99_wait_us = std::stod(value);
+        else return false;
+    }
+
+    return argc % 2 == 1 && (options.gate == "all" || options.gate == "gate" || options.gate == "compact");
+}
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    options_t options;
+    if (!parse(argc, argv, options))
+    {
+        std::cerr
+            << "usage: " << argv[0]
+            << " [--gate all|gate|compact] [--seed N] [--rounds N] [--clients N] [--servers N] [--sessions N]"
+            << " [--min-sessions-per-second X] [--max-p99-wait-us X]" << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    bool is_passed = true;
+
+    if (options.gate == "all" || options.gate == "gate")
+    {
+        is_passed = run<rendezvouscxx::gate_t<i_stress_server_t>>("gate_t", options) && is_passed;
+    }
+
+    if (options.gate == "all" || options.gate == "compact")
+    {
+        is_passed = run<rendezvouscxx::compact_gate_t<i_stress_server_t>>("compact_gate_t", options) && is_passed;
+    }
+
+    return is_passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}